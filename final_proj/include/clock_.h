@@ -7,5 +7,7 @@
 #define AHB_FREQ 48000000
 
 void SystemClock_Config(void);
+void clock_tick_init(void);
+uint32_t clock_get_ms(void);
 
 #endif // EPL_CLOCK_H
\ No newline at end of file
@@ -0,0 +1,45 @@
+#ifndef STATS_H_
+#define STATS_H_
+
+#include <stm32f0xx.h>
+
+#define STATS_RING_SIZE 16              // Anzahl der letzten Spiele, die im RAM gehalten werden
+
+// Aufzeichnung eines einzelnen Spiels
+typedef struct {
+    uint8_t won;                        // 1 = gewonnen, 0 = verloren
+    uint8_t shots_fired;                // eigene Schüsse
+    uint8_t shots_received;             // Schüsse des Gegners
+    uint8_t hits;                       // eigene Treffer beim Gegner
+    uint8_t turns;                      // Anzahl der Runden (Gegnerschuss + eigener Schuss)
+    uint32_t duration_ms;               // Dauer von HD_START bis Spielende
+} GameRecord_t;
+
+// Statistik über das ganze Turnier: Ringpuffer + laufende Aggregate
+typedef struct {
+    GameRecord_t ring[STATS_RING_SIZE];
+    uint16_t head;                      // nächste Schreibposition im Ring
+    uint16_t count;                     // Anzahl gültiger Einträge im Ring
+
+    GameRecord_t current;               // Daten des laufenden Spiels
+    uint32_t start_ms;                  // Startzeit des laufenden Spiels
+
+    uint32_t games;                     // Anzahl abgeschlossener Spiele
+    uint32_t wins;                      // Anzahl gewonnener Spiele
+    uint32_t win_shots_sum;             // Summe der Schüsse in gewonnenen Spielen
+    uint8_t win_shots_min;              // wenigste Schüsse bis zum Sieg
+    uint8_t win_shots_max;              // meiste Schüsse bis zum Sieg
+    uint32_t turns_sum;                 // Summe aller Runden
+    uint32_t duration_sum_ms;           // Summe aller Spieldauern
+} Stats_t;
+
+void stats_init(Stats_t* stats);
+void stats_game_start(Stats_t* stats, uint32_t now_ms);
+void stats_shot_fired(Stats_t* stats);
+void stats_shot_result(Stats_t* stats, int hit);
+void stats_shot_received(Stats_t* stats);
+void stats_game_end(Stats_t* stats, int won, uint32_t now_ms);
+int stats_format_summary(const Stats_t* stats, char* buffer, int max_len);
+int stats_format_record(const Stats_t* stats, int back, char* buffer, int max_len);
+
+#endif // STATS_H_
@@ -38,4 +38,23 @@ void SystemClock_Config(void)
   // wait for clock switch to become stable
   while ((RCC->CFGR & RCC_CFGR_SWS) != (0b11 << RCC_CFGR_SWS_Pos))
     ;
-}
\ No newline at end of file
+}
+
+// Millisekunden-Zähler, wird im SysTick-Interrupt hochgezählt
+static volatile uint32_t ms_ticks = 0;
+
+void clock_tick_init(void)
+{
+  // SysTick auf 1 ms Periode einstellen (AHB_FREQ / 1000 Takte pro Tick)
+  SysTick_Config(AHB_FREQ / 1000);
+}
+
+void SysTick_Handler(void)
+{
+  ms_ticks++;
+}
+
+uint32_t clock_get_ms(void)
+{
+  return ms_ticks;
+}
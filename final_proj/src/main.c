@@ -1,21 +1,19 @@
 #include "clock_.h"
 #include "fifo.h"
 #include "uart.h"
+#include "stats.h"
 #include <string.h>
 #include <stdio.h>
 
 #define DEVICE_NAME "LEO"               // Name des Spielers
 #define FIELD_SZ 10                     // Größe des Spielfelds
+#define NUM_SHIPS 10                    // insgesammte Anzahl an Schiffen
 
 #pragma region Global Variables
 
-uint8_t opponent_field[FIELD_SZ][FIELD_SZ];         // Spielfeld des Gegners zum speichern von getroffenen oder verfehlten Schüssen
-uint8_t original_field[FIELD_SZ][FIELD_SZ];         // Originales eigenes Spielfeld für die Ausgabe im Game over
-uint8_t next_shot_row = 0, next_shot_col = 0;       // row und col für get_next_shot
-int hit_count = 0;                                  // Check-Variable für getroffene Schiffe
 int games_played = 0;                               // Anzahl der gespielten Spiele
 int target_games = 100;                             // Anzahl der Spiele, die gespielt werden sollen
-const int NUM_SHIPS = 10;                           // insgesammte Anzahl an Schiffen 
+Stats_t stats;                                      // Turnierstatistik (letzte Spiele + Aggregate)
 
 // typ aufzählung bekannter Konstanten für gamestate
 typedef enum
@@ -25,9 +23,17 @@ typedef enum
     MY_TURN,
     WAITING_FOR_RESPONSE,
     OP_TURN,
-    GAME_OVER
+    GAME_OVER,
+    TOURNAMENT_OVER
 } GameState_t;
-GameState_t current_state = WAITING_START;          // Startzustand des Spiels
+
+// Rückgabewerte von process_shot
+typedef enum
+{
+    SHOT_MISS,
+    SHOT_HIT,
+    SHOT_SUNK
+} ShotResult_t;
 
 // struct Ship_t mit Daten für row col länge und ausrichtung
 typedef struct
@@ -58,6 +64,33 @@ Ship_t ships[] = {
     {6, 9, 2, 0}, // Zeile 6, Spalte 9, vertikal
     {9, 5, 2, 1}  // Zeile 9, Spalte 5, horizontal
 };
+
+// feste Aufstellung, wird einmal beim Start aus der Schiffsliste gebaut und ändert sich nie
+typedef struct
+{
+    uint8_t field[FIELD_SZ][FIELD_SZ];              // Schiffslängen pro Feld für die SF-Ausgabe im Game over
+    uint8_t ship_map[FIELD_SZ][FIELD_SZ];           // Schiffsindex + 1 pro Feld, 0 = Wasser
+    uint8_t checksum[FIELD_SZ];                     // Checksumme für jede Zeile
+    uint8_t ship_cells[NUM_SHIPS];                  // Anzahl der Felder pro Schiff
+    uint8_t total_cells;                            // Anzahl aller Schiffsteile
+} Layout_t;
+
+// kompletter Zustand eines laufenden Spiels
+typedef struct
+{
+    uint8_t field[FIELD_SZ][FIELD_SZ];              // eigenes Feld: Schiffsindex + 1, getroffene Teile werden 0
+    uint8_t opponent_field[FIELD_SZ][FIELD_SZ];     // Spielfeld des Gegners zum speichern von getroffenen oder verfehlten Schüssen
+    uint8_t ship_cells_left[NUM_SHIPS];             // verbleibende Felder pro Schiff, 0 = versenkt
+    uint8_t cells_left;                             // verbleibende Schiffsteile, 0 = verloren
+    uint8_t next_shot_row, next_shot_col;           // row und col für get_next_shot
+    GameState_t state;                              // Zustand der State-Machine
+} GameContext_t;
+
+Layout_t layout;                                    // eigene Aufstellung
+GameContext_t contexts[2];                          // Doppelpuffer: laufendes und vorbereitetes Spiel
+GameContext_t *game = &contexts[0];                 // laufendes Spiel
+GameContext_t *next_game = &contexts[1];            // fertig vorbereitetes nächstes Spiel
+int next_game_ready = 0;                            // 1 wenn next_game fertig vorbereitet ist
 #pragma endregion Global Variables
 
 
@@ -90,9 +123,9 @@ int can_place_ship(uint8_t field[FIELD_SZ][FIELD_SZ], Ship_t ship)
     return 1; // kann platziert werden
 }
 
-void place_ship(uint8_t field[FIELD_SZ][FIELD_SZ], Ship_t ship)
+void place_ship(uint8_t field[FIELD_SZ][FIELD_SZ], Ship_t ship, uint8_t value)
 {
-    // geht länge des Schiffs durch und platziert es mit nummer der Länge im feld
+    // geht länge des Schiffs durch und platziert es mit dem übergebenen Wert im feld
     for (int i = 0; i < ship.length; i++)
     {
         int row, col;
@@ -104,24 +137,7 @@ void place_ship(uint8_t field[FIELD_SZ][FIELD_SZ], Ship_t ship)
             row = ship.row + i;
             col = ship.col;
         }
-        field[row][col] = ship.length;
-    }
-}
-
-void init_field(uint8_t field[FIELD_SZ][FIELD_SZ])
-{
-    //initialisiert das Spielfeld und platziert die Schiffe
-
-    // alle Felder auf 0 setzen um fehler zu vermeiden und um das Spielfeld zu initialisieren
-    // memset setzt alle Bytes im Array auf 0 (erste spalte ist das Array, zweite spalte ist der Wert der gesetzt wird und dritte spalte ist die Gröse des Arrays)
-    memset(field, 0, FIELD_SZ * FIELD_SZ * sizeof(uint8_t));
-
-    for (int i = 0; i < NUM_SHIPS; i++)
-    {
-        if (can_place_ship(field, ships[i]))    // check mit can_place_ship ob Koordinaten valid sind und ob Feld leer ist 
-        {
-            place_ship(field, ships[i]);        // platziere Schiff mit place_ship
-        }
+        field[row][col] = value;
     }
 }
 
@@ -141,6 +157,28 @@ void calculate_checksum(uint8_t field[FIELD_SZ][FIELD_SZ], uint8_t checksum[FIEL
     }
 }
 
+void init_layout(Layout_t *lay)
+{
+    // baut die feste Aufstellung einmalig auf: Feld mit Schiffslängen, Schiffsindex pro Feld,
+    // Felder pro Schiff und Checksumme
+
+    // memset setzt alle Bytes im Array auf 0 (erste spalte ist das Array, zweite spalte ist der Wert der gesetzt wird und dritte spalte ist die Gröse des Arrays)
+    memset(lay, 0, sizeof(*lay));
+
+    for (int i = 0; i < NUM_SHIPS; i++)
+    {
+        if (can_place_ship(lay->field, ships[i]))               // check mit can_place_ship ob Koordinaten valid sind und ob Feld leer ist 
+        {
+            place_ship(lay->field, ships[i], ships[i].length);  // Länge für die SF-Ausgabe
+            place_ship(lay->ship_map, ships[i], i + 1);         // Index für die Zuordnung Treffer -> Schiff
+            lay->ship_cells[i] = ships[i].length;
+            lay->total_cells += ships[i].length;
+        }
+    }
+
+    calculate_checksum(lay->field, lay->checksum);
+}
+
 void send_checksum(uint8_t checksum[FIELD_SZ])
 {
     // sendet die Checksumme laut Protokoll
@@ -176,19 +214,25 @@ int parse_boom_message(const char *buffer, int *row, int *col)
     return 1;
 }
 
-int process_shot(uint8_t field[FIELD_SZ][FIELD_SZ], int row, int col)
+ShotResult_t process_shot(GameContext_t *ctx, int row, int col)
 {
     // kontrolliert ob boom vom Host ein HIT oder ein MISS war 
     // wenn feld an den Koordinaten > 0 ist => Schiffsteil => hit vom Host 
-    if (field[row][col] > 0)
+    // die Zähler werden bei jedem Treffer mitgeführt, dadurch ist versenkt und game over O(1)
+    uint8_t ship = ctx->field[row][col];
+    if (ship > 0)
     {
-        field[row][col] = 0;            // markiert Feld mit 0 (getroffenes Schiffsteil)
-        hit_count++;                    // hitcount für kontrolle von ob game over
-        return 1;                       // Hit
+        ctx->field[row][col] = 0;                   // markiert Feld mit 0 (getroffenes Schiffsteil)
+        ctx->cells_left--;                          // für kontrolle von ob game over
+        if (--ctx->ship_cells_left[ship - 1] == 0)  // letztes Feld des Schiffs getroffen
+        {
+            return SHOT_SUNK;
+        }
+        return SHOT_HIT;
     }
-    else                                // wenn MISS dan einfach 0 lassen rückgabewert 0
+    else                                            // wenn MISS dan einfach 0 lassen
     {
-        return 0; // Miss
+        return SHOT_MISS;
     }
 }
 
@@ -283,20 +327,20 @@ void send_shot(int row, int col)
     uart_write_string("\n");
 }
 
-void strategy_shot(uint8_t field[FIELD_SZ][FIELD_SZ])
+void strategy_shot(GameContext_t *ctx)
 {
     // sendet Schuss mit send_shot auf Koordinaten welche in get_next_shot
     // ausgewählt werden 
-    // &next_shot_x ist die adresse des int wo get_next_shot daten hinschiebt 
-    get_next_shot(field, &next_shot_row, &next_shot_col);
+    // &ctx->next_shot_x ist die adresse des int wo get_next_shot daten hinschiebt 
+    get_next_shot(ctx->opponent_field, &ctx->next_shot_row, &ctx->next_shot_col);
 
-    if (next_shot_row >= 0 && next_shot_col >= 0)
+    if (ctx->next_shot_row >= 0 && ctx->next_shot_col >= 0)
     {
-        send_shot(next_shot_row, next_shot_col);
+        send_shot(ctx->next_shot_row, ctx->next_shot_col);
     }
 }
 
-void send_game_over(uint8_t field[FIELD_SZ][FIELD_SZ])
+void send_game_over(void)
 {
     // schickt die DH_SF nachricht mit dem originalen feld zeile für zeile
     for (int r = 0; r < FIELD_SZ; r++)                      // geht jede Zeile Durch
@@ -306,48 +350,92 @@ void send_game_over(uint8_t field[FIELD_SZ][FIELD_SZ])
         uart_write_string("D");
         for (int c = 0; c < FIELD_SZ; c++)                  // geht jede Spalte durch
         {
-            uart_write_char('0' + original_field[r][c]);    // schreibt jede Zahl der Spalte in der aktuellen Zeile
+            uart_write_char('0' + layout.field[r][c]);      // schreibt jede Zahl der Spalte in der aktuellen Zeile
         }
         uart_write_string("\n");
     }
 }
 
-void reset_game(uint8_t field[FIELD_SZ][FIELD_SZ], uint8_t checksum[FIELD_SZ])
+void send_stats(const char *args)
 {
-    // reseten des Spiels für das Turnament
-    init_field(field);                                      // initialisiert das Feld
-
-    memcpy(original_field, field, sizeof(original_field));  // kopiert das Spielfeld "field" in das Array "original_field" für die SF-Ausgabe
+    // beantwortet die Statistik-Abfrage, ohne den Spielzustand zu verändern
+    // "HD_STATS" -> Aggregate, "HD_STATS_n" -> n-letztes Spiel aus dem Ring (0 = zuletzt)
+    char out[64];
 
-    calculate_checksum(field, checksum);                    // berechnet die neue Checksum
+    if (args[0] == '_')
+    {
+        int back = 0;
+        // bricht ab sobald back außerhalb des Rings liegt, damit kein Überlauf möglich ist
+        for (const char *p = args + 1; *p >= '0' && *p <= '9' && back < STATS_RING_SIZE; p++)
+        {
+            back = back * 10 + (*p - '0');
+        }
+        stats_format_record(&stats, back, out, sizeof(out));
+    }
+    else
+    {
+        stats_format_summary(&stats, out, sizeof(out));
+    }
+    uart_write_string(out);
+}
 
-    memset(opponent_field, 0, sizeof(opponent_field));      // Setze das Spielfeld des Gegners auf leer
+void prepare_game(GameContext_t *ctx)
+{
+    // setzt einen Spielkontext auf den Startzustand, nur Kopien aus der fertigen Aufstellung
+    memcpy(ctx->field, layout.ship_map, sizeof(ctx->field));                    // eigenes Feld mit Schiffsindex pro Feld
+    memset(ctx->opponent_field, 0, sizeof(ctx->opponent_field));                // Setze das Spielfeld des Gegners auf leer
+    memcpy(ctx->ship_cells_left, layout.ship_cells, sizeof(ctx->ship_cells_left));
+    ctx->cells_left = layout.total_cells;
+    ctx->next_shot_row = 0;                                                     // setze die nächste Schussposition zurück
+    ctx->next_shot_col = 0;
+    ctx->state = WAITING_START;
+}
 
-    hit_count = 0;                                          // setze hit_count zurück
-    next_shot_row = 0;                                      // setze die nächste Schussposition zurück
-    next_shot_col = 0;                                      // setze die nächste Schussposition zurück
-    current_state = WAITING_START;                          // setze den Zustand zurück auf WAITING_START
+void reset_game(void)
+{
+    // reseten des Spiels für das Turnament
+    // tauscht nur die Zeiger, das nächste Spiel ist schon vorbereitet -> keine Lücke zwischen den Spielen
+    // der alte Kontext wird danach in der Hauptschleife im Leerlauf neu vorbereitet
+    GameContext_t *finished = game;
+    game = next_game;
+    next_game = finished;
+    next_game_ready = 0;
 }
 #pragma endregion Funktionen
 
 int main(void)
 {
-    uint8_t field[FIELD_SZ][FIELD_SZ];  // Spielfeld
-    uint8_t checksum[FIELD_SZ];         // Checksumme für jede Zeile
     char buffer[32];                    // Puffer für empfangene Nachrichten
 
     // initialisiere UART
     uart_init();
+    clock_tick_init();                  // ms-Zeitbasis für die Spieldauer
+    stats_init(&stats);
 
-    reset_game(field, checksum);        // führt alle initialisierungen durch
+    init_layout(&layout);               // baut die Aufstellung einmalig auf
+    prepare_game(game);                 // erstes Spiel
 
     while (1)
     {
         // länge der auf der uart empfangenen Nachricht
         int len = uart_read_line_non_blocking(buffer, sizeof(buffer));      // array Buffer in das die uart_read_line_non_blocking schreibt, size of Buffer ist maximale länge
 
+        // bereitet das nächste Spiel vor, solange das aktuelle noch läuft
+        if (!next_game_ready)
+        {
+            prepare_game(next_game);
+            next_game_ready = 1;
+        }
+
+        // Statistik-Abfrage ist in jedem Zustand möglich und wird vor der State-Machine verbraucht
+        if (len > 0 && strncmp(buffer, "HD_STATS", 8) == 0)
+        {
+            send_stats(buffer + 8);
+            len = 0;
+        }
+
         // State-Machine des Spiels
-        switch (current_state)
+        switch (game->state)
         {
         #pragma region WAITING_START
         case WAITING_START:
@@ -358,7 +446,8 @@ int main(void)
                 uart_write_string("DH_START_");
                 uart_write_string(DEVICE_NAME);
                 uart_write_string("\n");
-                current_state = WAITING_CS;
+                stats_game_start(&stats, clock_get_ms());
+                game->state = WAITING_CS;
             }
             break;
         #pragma endregion WAITING_START
@@ -369,8 +458,8 @@ int main(void)
             // wechselt anschließend in den state OP_TURN
             if (len > 0 && strncmp(buffer, "HD_CS_", 6) == 0)
             {
-                send_checksum(checksum);
-                current_state = OP_TURN;       
+                send_checksum(layout.checksum);
+                game->state = OP_TURN;
             }
             break;
         #pragma endregion WAITING_CS
@@ -384,12 +473,13 @@ int main(void)
                 int row, col;
                 if (parse_boom_message(buffer, &row, &col))             // parsed die Koordinaten 
                 {
-                    int is_hit = process_shot(field, row, col);         // checked ob es ein Hit war
-                    if (is_hit)
+                    stats_shot_received(&stats);
+                    ShotResult_t result = process_shot(game, row, col); // checked ob es ein Hit war
+                    if (result != SHOT_MISS)
                     {
-                        if (hit_count == 30)                            // checkt für Spielende ob Anzahl an maximalen Hits erreicht ist  
+                        if (game->cells_left == 0)                      // checkt für Spielende ob alle Schiffsteile getroffen sind
                         {
-                            current_state = GAME_OVER;                  // wenn ja wechselt zu GAME_OVER
+                            game->state = GAME_OVER;                    // wenn ja wechselt zu GAME_OVER
                         }
                         else
                         {
@@ -400,13 +490,13 @@ int main(void)
                     {
                         uart_write_string("DH_BOOM_M\n");               // Miss senden
                     }
-                    if(hit_count == 30)
+                    if (game->cells_left == 0)
                     {
-                        current_state = GAME_OVER;
+                        game->state = GAME_OVER;
                     }
                     else
                     {
-                        current_state = MY_TURN;                            // wechselt zu MY_TURN
+                        game->state = MY_TURN;                          // wechselt zu MY_TURN
                     }
                     
                 }
@@ -417,8 +507,9 @@ int main(void)
         #pragma region MY_TURN
         case MY_TURN:
             // schiest direkt mittels strategy_shot zurück und wechselt dann zu WAITING_FOr_RESPONSE
-            strategy_shot(opponent_field);
-            current_state = WAITING_FOR_RESPONSE;       // Wechsel zu WAITING_FOR_RESPONSE
+            strategy_shot(game);
+            stats_shot_fired(&stats);
+            game->state = WAITING_FOR_RESPONSE;         // Wechsel zu WAITING_FOR_RESPONSE
             break;
         #pragma endregion MY_TURN
 
@@ -429,18 +520,21 @@ int main(void)
             {
                 if (strncmp(buffer, "HD_BOOM_H", 9) == 0)
                 {
-                    opponent_field[next_shot_row][next_shot_col] = 1;           // markiert opponent_field mit 1 für Mit 
-                    current_state = OP_TURN;
+                    game->opponent_field[game->next_shot_row][game->next_shot_col] = 1;           // markiert opponent_field mit 1 für Mit 
+                    stats_shot_result(&stats, 1);
+                    game->state = OP_TURN;
                 }
                 else if (strncmp(buffer, "HD_BOOM_M", 9) == 0)
                 {
-                    opponent_field[next_shot_row][next_shot_col] = 2;           // markiert opponent_field mit 2 für Miss
-                    current_state = OP_TURN;
+                    game->opponent_field[game->next_shot_row][game->next_shot_col] = 2;           // markiert opponent_field mit 2 für Miss
+                    stats_shot_result(&stats, 0);
+                    game->state = OP_TURN;
                 }
                 else if (strncmp(buffer, "HD_SF", 5) == 0)
                 {
                     // wenn Gegner keine schüsse hat sendet HD_SF -> GAME_OVER
-                    current_state = GAME_OVER;
+                    stats_shot_result(&stats, 1);                               // letzter Schuss war der spielentscheidende Treffer
+                    game->state = GAME_OVER;
                 }
             }
             break;
@@ -449,27 +543,43 @@ int main(void)
         #pragma region GAME_OVER
         case GAME_OVER:
             // geht durch die Game over prozedur durch
-            if (hit_count == 30)                                    // checkt ob man verloren hat 
+            if (game->cells_left == 0)                              // checkt ob man verloren hat 
             {
-                send_game_over(field);                              // sendet eigenes Spielfeld mit dem Präfix SF
+                send_game_over();                                   // sendet eigenes Spielfeld mit dem Präfix SF
                 games_played++;                                     // zählt gespielte Spiele hoch
+                stats_game_end(&stats, 0, clock_get_ms());          // Niederlage aufzeichnen
 
                 if (games_played < target_games)                    // checkt ob für turnament anzahl an spiele erreicht wurde
                 {
-                    reset_game(field, checksum);                    // führt den Reset des Spiels aus 
+                    reset_game();                                   // führt den Reset des Spiels aus 
+                }
+                else
+                {
+                    game->state = TOURNAMENT_OVER;                  // Turnier fertig, Spielende nur einmal aufzeichnen
                 }
             }
             else if (len > 0 && strncmp(buffer, "HD_SF", 5) == 0)   // checkt ob man gewonnen hat (Gegner schickt sein Spielfeld)
             {
                 games_played++;                                     // zählt gespielte Spiele hoch
-                send_game_over(field);
+                stats_game_end(&stats, 1, clock_get_ms());          // Sieg aufzeichnen
+                send_game_over();
                 if (games_played < target_games)                    // checkt ob für turnament anzahl an spiele erreicht wurde
                 {
-                    reset_game(field, checksum);                    // führt den Reset des Spiels aus 
+                    reset_game();                                   // führt den Reset des Spiels aus 
+                }
+                else
+                {
+                    game->state = TOURNAMENT_OVER;                  // Turnier fertig, Spielende nur einmal aufzeichnen
                 }
             }
             break;
             #pragma endregion GAME_OVER
+
+        #pragma region TOURNAMENT_OVER
+        case TOURNAMENT_OVER:
+            // Endzustand nach dem letzten Turnierspiel, nur noch HD_STATS wird beantwortet
+            break;
+        #pragma endregion TOURNAMENT_OVER
         }
     }
 
@@ -0,0 +1,115 @@
+#include "stats.h"
+#include <string.h>
+#include <stdio.h>
+
+void stats_init(Stats_t* stats)
+{
+    // setzt Ringpuffer und alle Aggregate auf 0
+    memset(stats, 0, sizeof(*stats));
+    stats->win_shots_min = 0xFF;                            // damit der erste Sieg das Minimum setzt
+}
+
+void stats_game_start(Stats_t* stats, uint32_t now_ms)
+{
+    // beginnt die Aufzeichnung eines neuen Spiels
+    memset(&stats->current, 0, sizeof(stats->current));
+    stats->start_ms = now_ms;
+}
+
+void stats_shot_fired(Stats_t* stats)
+{
+    stats->current.shots_fired++;
+}
+
+void stats_shot_result(Stats_t* stats, int hit)
+{
+    // Antwort des Hosts auf den eigenen Schuss
+    if (hit)
+    {
+        stats->current.hits++;
+    }
+}
+
+void stats_shot_received(Stats_t* stats)
+{
+    // jeder Gegnerschuss beginnt eine neue Runde, da der Gegner immer zuerst schießt
+    stats->current.shots_received++;
+    stats->current.turns++;
+}
+
+void stats_game_end(Stats_t* stats, int won, uint32_t now_ms)
+{
+    // schließt das laufende Spiel ab, schreibt es in den Ring und aktualisiert die Aggregate
+    GameRecord_t* rec = &stats->current;
+    rec->won = won ? 1 : 0;
+    rec->duration_ms = now_ms - stats->start_ms;            // unsigned Subtraktion ist auch bei Überlauf korrekt
+
+    stats->ring[stats->head] = *rec;
+    stats->head = (stats->head + 1) % STATS_RING_SIZE;      // bei vollem Ring wird das älteste Spiel überschrieben
+    if (stats->count < STATS_RING_SIZE)
+    {
+        stats->count++;
+    }
+
+    stats->games++;
+    stats->turns_sum += rec->turns;
+    stats->duration_sum_ms += rec->duration_ms;
+
+    if (rec->won)
+    {
+        stats->wins++;
+        stats->win_shots_sum += rec->shots_fired;
+        if (rec->shots_fired < stats->win_shots_min)
+        {
+            stats->win_shots_min = rec->shots_fired;
+        }
+        if (rec->shots_fired > stats->win_shots_max)
+        {
+            stats->win_shots_max = rec->shots_fired;
+        }
+    }
+}
+
+int stats_format_summary(const Stats_t* stats, char* buffer, int max_len)
+{
+    // Format: DH_STATS_<spiele>_<siege>_<winrate %>_<mittel>_<min>_<max>_<ms pro runde>
+    // Mittelwert der Schüsse bis zum Sieg mit einer Nachkommastelle (Festkomma x10)
+    uint32_t mean_x10 = 0, min = 0, max = 0, rate = 0, turn_ms = 0;
+
+    if (stats->games > 0)
+    {
+        rate = stats->wins * 100 / stats->games;
+    }
+    if (stats->wins > 0)
+    {
+        mean_x10 = stats->win_shots_sum * 10 / stats->wins;
+        min = stats->win_shots_min;
+        max = stats->win_shots_max;
+    }
+    if (stats->turns_sum > 0)
+    {
+        turn_ms = stats->duration_sum_ms / stats->turns_sum;
+    }
+
+    return snprintf(buffer, max_len, "DH_STATS_%lu_%lu_%lu_%lu.%lu_%lu_%lu_%lu\n",
+                    (unsigned long)stats->games, (unsigned long)stats->wins, (unsigned long)rate,
+                    (unsigned long)(mean_x10 / 10), (unsigned long)(mean_x10 % 10),
+                    (unsigned long)min, (unsigned long)max, (unsigned long)turn_ms);
+}
+
+int stats_format_record(const Stats_t* stats, int back, char* buffer, int max_len)
+{
+    // Format: DH_GAME_<w/l>_<schüsse>_<erhalten>_<treffer>_<runden>_<ms>
+    // back = 0 ist das zuletzt beendete Spiel, back = 1 das davor usw.
+    if (back < 0 || back >= stats->count)
+    {
+        return snprintf(buffer, max_len, "DH_GAME_NONE\n");
+    }
+
+    int idx = (stats->head + STATS_RING_SIZE - 1 - back) % STATS_RING_SIZE;
+    const GameRecord_t* rec = &stats->ring[idx];
+
+    return snprintf(buffer, max_len, "DH_GAME_%c_%u_%u_%u_%u_%lu\n",
+                    rec->won ? 'W' : 'L', rec->shots_fired, rec->shots_received,
+                    rec->hits, rec->turns, (unsigned long)rec->duration_ms);
+}